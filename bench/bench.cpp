@@ -0,0 +1,240 @@
+//--------------------------------------------------------------------------------
+// Microbenchmarks for decimal_float and to_chars.
+//
+//   g++ -std=gnu++20 -O2 -march=native -I.. bench.cpp -o bench [-lryu]
+//   ./bench [filter]
+//
+// Ryu and Dragonbox are timed as well when their headers are on the include path. Add
+// -DSCHUBFACH_EXPONENT_TABLES or -DSCHUBFACH_COMPACT_TABLES to compare the table modes,
+// and -DSCHUBFACH_CHECKED to measure the cost of the internal checks. With
+// -DSCHUBFACH_STATS each row also shows the share of values that left decimal_float
+// through each exit, which counting slows down a little.
+//--------------------------------------------------------------------------------
+
+#include "schubfach.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#if __has_include(<ryu/ryu.h>)
+#include <ryu/ryu.h>
+#define BENCH_RYU 1
+#endif
+
+#if __has_include(<dragonbox/dragonbox_to_chars.h>)
+#include <dragonbox/dragonbox_to_chars.h>
+#define BENCH_DRAGONBOX 1
+#endif
+
+namespace {
+
+constexpr size_t sample_size = 1 << 16;
+constexpr double min_seconds = 0.25;
+
+const char* filter = nullptr;
+volatile uint64_t sink;
+
+template <typename Float> const char* type_name() {
+  if constexpr (std::is_same_v<Float, float>)
+    return "float";
+  else if constexpr (std::is_same_v<Float, double>)
+    return "double";
+  else if constexpr (std::is_same_v<Float, long double>)
+    return "long double";
+  else
+    return "float128";
+}
+
+template <typename Float> Float from_bits(typename schubfach::float_traits<Float>::uint_t bits) {
+  return schubfach::reinterpret_bits<Float>(bits);
+}
+
+// Finite values with every significand and exponent bit random.
+template <typename Float> std::vector<Float> uniform_bits(std::mt19937_64& rng) {
+  using float_traits = schubfach::float_traits<Float>;
+  using uint_t = typename float_traits::uint_t;
+
+  std::vector<Float> values;
+  while (values.size() < sample_size) {
+    uint_t bits = static_cast<uint_t>((static_cast<__uint128_t>(rng()) << 64) | rng());
+    bits &= float_traits::sign_mask | float_traits::exponent_mask | float_traits::significand_mask;
+    if ((bits & float_traits::exponent_mask) == float_traits::exponent_mask || (bits & float_traits::exponent_mask) == 0)
+      continue;
+    if (!float_traits::has_hidden_bit)
+      bits |= uint_t{1} << (float_traits::significand_width - 1);
+    values.push_back(from_bits<Float>(bits));
+  }
+  return values;
+}
+
+// One to four significant digits, e.g. 0.1, 1.25, 37.5.
+template <typename Float> std::vector<Float> short_decimals(std::mt19937_64& rng) {
+  std::vector<Float> values;
+  for (size_t i = 0; i < sample_size; ++i) {
+    const std::string text = std::to_string(1 + rng() % 9999) + "e" + std::to_string(static_cast<int>(rng() % 9) - 6);
+    Float value{};
+    schubfach::from_chars(text.data(), text.data() + text.size(), value);
+    values.push_back(value);
+  }
+  return values;
+}
+
+template <typename Float> std::vector<Float> integers(std::mt19937_64& rng) {
+  std::vector<Float> values;
+  for (size_t i = 0; i < sample_size; ++i)
+    values.push_back(static_cast<Float>(rng() >> (rng() % 64)));
+  return values;
+}
+
+template <typename Float> std::vector<Float> subnormals(std::mt19937_64& rng) {
+  using float_traits = schubfach::float_traits<Float>;
+  using uint_t = typename float_traits::uint_t;
+
+  std::vector<Float> values;
+  while (values.size() < sample_size) {
+    const uint_t bits = static_cast<uint_t>((static_cast<__uint128_t>(rng()) << 64) | rng()) & float_traits::significand_mask &
+                        ~(uint_t{1} << (float_traits::significand_width - 1));
+    if (bits != 0)
+      values.push_back(from_bits<Float>(bits));
+  }
+  return values;
+}
+
+// Normal powers of two, where the lower boundary is closer.
+template <typename Float> std::vector<Float> powers_of_two(std::mt19937_64& rng) {
+  using float_traits = schubfach::float_traits<Float>;
+  using uint_t = typename float_traits::uint_t;
+  constexpr uint_t max_field = (float_traits::exponent_mask >> float_traits::exponent_shift) - 1;
+
+  std::vector<Float> values;
+  for (size_t i = 0; i < sample_size; ++i) {
+    uint_t bits = ((2 + rng() % (max_field - 1)) << float_traits::exponent_shift);
+    if (!float_traits::has_hidden_bit)
+      bits |= uint_t{1} << (float_traits::significand_width - 1);
+    values.push_back(from_bits<Float>(bits));
+  }
+  return values;
+}
+
+template <typename Float, typename Fn> void run(const char* what, const char* distribution, const std::vector<Float>& values, Fn fn) {
+  char name[128];
+  std::snprintf(name, sizeof name, "%s<%s>/%s", what, type_name<Float>(), distribution);
+  if (filter != nullptr && std::strstr(name, filter) == nullptr)
+    return;
+
+  uint64_t checksum = 0;
+  size_t iterations = 0;
+#ifdef SCHUBFACH_STATS
+  const schubfach::conversion_stats before = schubfach::collect_stats();
+#endif
+  const auto start = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed{};
+  do {
+    for (const Float value : values)
+      checksum += fn(value);
+    iterations += values.size();
+    elapsed = std::chrono::steady_clock::now() - start;
+  } while (elapsed.count() < min_seconds);
+  sink = checksum;
+
+  std::printf("%-44s %10.2f ns", name, elapsed.count() * 1e9 / iterations);
+#ifdef SCHUBFACH_STATS
+  // Rows whose function does not go through decimal_float count nothing.
+  const schubfach::conversion_stats after = schubfach::collect_stats();
+  for (const auto exit : {schubfach::conversion_stats::integer, schubfach::conversion_stats::sp,
+                          schubfach::conversion_stats::uw, schubfach::conversion_stats::mid}) {
+    const uint64_t count = after.counts[exit] - before.counts[exit];
+    if (count != 0)
+      std::printf(" %7.1f%%", 100.0 * count / iterations);
+    else
+      std::printf(" %8s", "-");
+  }
+#endif
+  std::printf("\n");
+}
+
+template <typename Float> void run_all(std::mt19937_64& rng) {
+  const std::pair<const char*, std::vector<Float>> distributions[] = {
+      {"uniform", uniform_bits<Float>(rng)},    {"short", short_decimals<Float>(rng)},
+      {"integer", integers<Float>(rng)},        {"subnormal", subnormals<Float>(rng)},
+      {"pow2", powers_of_two<Float>(rng)},
+  };
+
+  for (const auto& [distribution, values] : distributions) {
+    run("decimal_float", distribution, values, [](Float value) {
+      const schubfach::decimal_float<Float> decimal(value);
+      return static_cast<uint64_t>(decimal.significand) + decimal.exponent;
+    });
+
+    run("to_chars", distribution, values, [](Float value) {
+      char buffer[schubfach::float_traits<Float>::max_chars];
+      return static_cast<uint64_t>(schubfach::to_chars(buffer, buffer + sizeof buffer, value) - buffer) + buffer[0];
+    });
+
+    if constexpr (std::is_same_v<Float, float> || std::is_same_v<Float, double> || std::is_same_v<Float, long double>) {
+      run("std::to_chars", distribution, values, [](Float value) {
+        char buffer[64];
+        return static_cast<uint64_t>(std::to_chars(buffer, buffer + sizeof buffer, value).ptr - buffer) + buffer[0];
+      });
+    }
+
+#ifdef BENCH_RYU
+    if constexpr (std::is_same_v<Float, float> || std::is_same_v<Float, double>) {
+      run("ryu", distribution, values, [](Float value) {
+        char buffer[32];
+        const int n = std::is_same_v<Float, float> ? f2s_buffered_n(value, buffer) : d2s_buffered_n(value, buffer);
+        return static_cast<uint64_t>(n) + buffer[0];
+      });
+    }
+#endif
+
+#ifdef BENCH_DRAGONBOX
+    if constexpr (std::is_same_v<Float, float> || std::is_same_v<Float, double>) {
+      run("dragonbox", distribution, values, [](Float value) {
+        char buffer[jkj::dragonbox::max_output_string_length<jkj::dragonbox::ieee754_binary64>];
+        return static_cast<uint64_t>(jkj::dragonbox::to_chars(value, buffer) - buffer) + buffer[0];
+      });
+    }
+#endif
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  filter = argc > 1 ? argv[1] : nullptr;
+
+  std::printf("tables: %s%s, checks: %s\n",
+#ifdef SCHUBFACH_COMPACT_TABLES
+              "compact",
+#else
+              "full",
+#endif
+#ifdef SCHUBFACH_EXPONENT_TABLES
+              " + exponent",
+#else
+              "",
+#endif
+#ifdef SCHUBFACH_CHECKED
+              "on");
+#else
+              "off");
+#endif
+#ifdef SCHUBFACH_STATS
+  std::printf("%-44s %13s %8s %8s %8s %8s\n", "Benchmark", "Time/value", "int", "sp", "u/w", "mid");
+#else
+  std::printf("%-44s %13s\n", "Benchmark", "Time/value");
+#endif
+  std::mt19937_64 rng(20240101);
+  run_all<float>(rng);
+  run_all<double>(rng);
+  run_all<long double>(rng);
+#ifdef __SIZEOF_FLOAT128__
+  run_all<__float128>(rng);
+#endif
+}
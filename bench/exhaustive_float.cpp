@@ -0,0 +1,153 @@
+//--------------------------------------------------------------------------------
+// Runs decimal_float<float> on every binary32 pattern and checks that the result
+// round-trips and that no decimal with one digit less does.
+//
+//   g++ -std=gnu++20 -O2 -march=native -pthread -I.. exhaustive_float.cpp -o exhaustive_float
+//   ./exhaustive_float [threads] [first last]
+//
+// first and last are inclusive bit patterns, e.g. 0x3f800000 0x3fffffff.
+//--------------------------------------------------------------------------------
+
+#include "schubfach.hpp"
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t block_size = 1 << 12;
+
+// A range of blocks [lo, hi) packed into one word. The owner pops blocks from the front and thieves take the back
+// half, both with a single compare-and-swap.
+struct alignas(64) work_range {
+  std::atomic<uint64_t> bounds;
+
+  static constexpr uint64_t pack(uint32_t lo, uint32_t hi) { return (uint64_t{hi} << 32) | lo; }
+
+  bool pop(uint32_t& block) {
+    uint64_t b = bounds.load(std::memory_order_relaxed);
+    while (static_cast<uint32_t>(b) < static_cast<uint32_t>(b >> 32)) {
+      if (bounds.compare_exchange_weak(b, b + 1, std::memory_order_relaxed)) {
+        block = static_cast<uint32_t>(b);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool steal(work_range& victim) {
+    uint64_t b = victim.bounds.load(std::memory_order_relaxed);
+    for (;;) {
+      const uint32_t lo = static_cast<uint32_t>(b);
+      const uint32_t hi = static_cast<uint32_t>(b >> 32);
+      if (lo >= hi || hi - lo < 2)
+        return false;
+      const uint32_t mid = lo + (hi - lo) / 2;
+      if (victim.bounds.compare_exchange_weak(b, pack(lo, mid), std::memory_order_relaxed)) {
+        bounds.store(pack(mid, hi), std::memory_order_relaxed);
+        return true;
+      }
+    }
+  }
+};
+
+bool parses_to(uint64_t significand, int32_t exponent, float expected) {
+  char buffer[32];
+  char* last = std::to_chars(buffer, buffer + 20, significand).ptr;
+  *last++ = 'e';
+  last = std::to_chars(last, buffer + sizeof buffer, exponent).ptr;
+
+  float value;
+  std::from_chars(buffer, last, value);
+  return schubfach::reinterpret_bits<uint32_t>(value) == schubfach::reinterpret_bits<uint32_t>(expected);
+}
+
+struct counters {
+  uint64_t values = 0;
+  uint64_t not_round_trip = 0;
+  uint64_t not_shortest = 0;
+};
+
+void check(uint32_t bits, counters& c) {
+  using float_traits = schubfach::float_traits<float>;
+  if ((bits & float_traits::exponent_mask) == float_traits::exponent_mask || (bits & ~float_traits::sign_mask) == 0)
+    return;
+
+  const float value = schubfach::reinterpret_bits<float>(bits);
+  const float magnitude = schubfach::reinterpret_bits<float>(bits & ~float_traits::sign_mask);
+  const schubfach::decimal_float<float> decimal(value);
+  ++c.values;
+
+  const bool ok = decimal.sign == ((bits & float_traits::sign_mask) ? -1 : 1) &&
+                  parses_to(decimal.significand, decimal.exponent, magnitude);
+  if (!ok && c.not_round_trip++ < 10)
+    std::printf("0x%08x: %ue%d does not round-trip\n", bits, decimal.significand, decimal.exponent);
+
+  if (decimal.significand >= 10) {
+    const uint32_t shorter = decimal.significand / 10;
+    if (parses_to(shorter, decimal.exponent + 1, magnitude) || parses_to(shorter + 1, decimal.exponent + 1, magnitude))
+      if (c.not_shortest++ < 10)
+        std::printf("0x%08x: %ue%d is not shortest\n", bits, decimal.significand, decimal.exponent);
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const unsigned threads = argc > 1 ? std::stoul(argv[1]) : std::max(1u, std::thread::hardware_concurrency());
+  const uint64_t first = argc > 3 ? std::stoull(argv[2], nullptr, 0) : 0;
+  const uint64_t last = argc > 3 ? std::stoull(argv[3], nullptr, 0) : 0xFFFFFFFF;
+  const uint32_t first_block = static_cast<uint32_t>(first / block_size);
+  const uint32_t blocks = static_cast<uint32_t>(last / block_size - first_block + 1);
+
+  std::vector<work_range> ranges(threads);
+  for (unsigned t = 0; t < threads; ++t)
+    ranges[t].bounds = work_range::pack(static_cast<uint32_t>(uint64_t{blocks} * t / threads),
+                                        static_cast<uint32_t>(uint64_t{blocks} * (t + 1) / threads));
+
+  std::vector<counters> results(threads);
+  const auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      counters c;
+      for (;;) {
+        uint32_t block;
+        while (ranges[t].pop(block)) {
+          const uint64_t lo = std::max(first, uint64_t{first_block + block} * block_size);
+          const uint64_t hi = std::min(last + 1, uint64_t{first_block + block + 1} * block_size);
+          for (uint64_t bits = lo; bits < hi; ++bits)
+            check(static_cast<uint32_t>(bits), c);
+        }
+
+        bool stolen = false;
+        for (unsigned i = 1; i < threads && !stolen; ++i)
+          stolen = ranges[t].steal(ranges[(t + i) % threads]);
+        if (!stolen)
+          break;
+      }
+      results[t] = c;
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  counters total;
+  for (const auto& c : results) {
+    total.values += c.values;
+    total.not_round_trip += c.not_round_trip;
+    total.not_shortest += c.not_shortest;
+  }
+
+  std::printf("%llu values, %llu not round-trip, %llu not shortest\n", static_cast<unsigned long long>(total.values),
+              static_cast<unsigned long long>(total.not_round_trip), static_cast<unsigned long long>(total.not_shortest));
+  std::printf("%.2f s on %u threads, %.1f M values/s\n", seconds, threads, total.values / seconds * 1e-6);
+  return total.not_round_trip == 0 && total.not_shortest == 0 ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+//--------------------------------------------------------------------------------
+// Streams a raw little-endian array of doubles or floats as CSV or NDJSON, with
+// shortest round-trip numbers. The input is memory-mapped, chunks of rows are
+// converted in parallel with convert_batch by schubfach::parallel_format and
+// written in order.
+//
+//   g++ -std=gnu++20 -O2 -march=native -pthread -I.. export.cpp -o export
+//   ./export [options] input.bin [output]
+//
+//   -f          input is binary32 instead of binary64
+//   -c columns  values per row, default 1
+//   -j          NDJSON, one array per row; inf and nan are written as null
+//   -t threads  conversion threads, default all cores
+//   -p          format with snprintf("%.17g") instead, as a baseline
+//   -s          report throughput on stderr
+//
+// The output goes to stdout when no path is given.
+//--------------------------------------------------------------------------------
+
+#define SCHUBFACH_PARALLEL
+#include "schubfach.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(std::endian::native == std::endian::little, "the input is read in place");
+
+namespace {
+
+constexpr size_t chunk_values = 1 << 16;
+constexpr size_t batch_size = 256;
+constexpr size_t max_value_chars = 32; // covers max_chars of both types and %.17g
+
+struct options {
+  size_t columns = 1;
+  bool ndjson = false;
+  bool use_printf = false;
+};
+
+// Formats the values [first, last) of the input, which start and end on row boundaries.
+template <typename Float> char* format(char* cursor, const Float* values, size_t first, size_t last, const options& opts) {
+  using float_traits = schubfach::float_traits<Float>;
+  using uint_t = typename float_traits::math_uint_t;
+
+  uint_t significands[batch_size];
+  int32_t exponents[batch_size];
+  int8_t signs[batch_size];
+  schubfach::float_class classes[batch_size];
+
+  for (size_t i = first; i < last; i += batch_size) {
+    const size_t n = std::min(batch_size, last - i);
+    if (!opts.use_printf)
+      schubfach::convert_batch(values + i, n, significands, exponents, signs, classes);
+
+    for (size_t j = 0; j < n; ++j) {
+      const size_t column = (i + j) % opts.columns;
+      if (column == 0 && opts.ndjson)
+        *cursor++ = '[';
+      else if (column != 0)
+        *cursor++ = ',';
+
+      if (opts.use_printf)
+        cursor += std::snprintf(cursor, max_value_chars, "%.17g", static_cast<double>(values[i + j]));
+      else if (opts.ndjson && classes[j] != schubfach::float_class::finite && classes[j] != schubfach::float_class::zero)
+        cursor = std::copy_n("null", 4, cursor);
+      else {
+        const schubfach::decimal_float<Float> decimal(significands[j], exponents[j], signs[j], classes[j]);
+        cursor = schubfach::write_exact_integer(schubfach::to_chars(cursor, cursor + float_traits::max_chars, decimal),
+                                                values[i + j], decimal);
+      }
+
+      if (column == opts.columns - 1) {
+        if (opts.ndjson)
+          *cursor++ = ']';
+        *cursor++ = '\n';
+      }
+    }
+  }
+  return cursor;
+}
+
+bool write_all(int fd, const char* data, size_t size) {
+  while (size != 0) {
+    const ssize_t n = ::write(fd, data, size);
+    if (n < 0)
+      return false;
+    data += n;
+    size -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+template <typename Float>
+bool run(const Float* values, size_t count, int fd, const options& opts, unsigned threads) {
+  const size_t rows_per_chunk = std::max<size_t>(1, chunk_values / opts.columns);
+  const size_t chunk_size = rows_per_chunk * opts.columns;
+  const size_t capacity = chunk_size * (max_value_chars + 1) + rows_per_chunk * 2;
+
+  return schubfach::parallel_format(
+      count, chunk_size, capacity,
+      [&](char* buffer, size_t first, size_t last) { return format(buffer, values, first, last, opts); },
+      [&](const char* data, size_t size) { return write_all(fd, data, size); }, threads);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  options opts;
+  bool binary32 = false;
+  bool stats = false;
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+  int i = 1;
+  for (; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; ++i) {
+    const std::string flag = argv[i];
+    if (flag == "-f")
+      binary32 = true;
+    else if (flag == "-c" && i + 1 < argc)
+      opts.columns = std::max(1ul, std::stoul(argv[++i]));
+    else if (flag == "-j")
+      opts.ndjson = true;
+    else if (flag == "-t" && i + 1 < argc)
+      threads = std::max(1ul, std::stoul(argv[++i]));
+    else if (flag == "-p")
+      opts.use_printf = true;
+    else if (flag == "-s")
+      stats = true;
+    else {
+      std::fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (i >= argc) {
+    std::fprintf(stderr, "usage: %s [-f] [-c columns] [-j] [-t threads] [-p] [-s] input.bin [output]\n", argv[0]);
+    return 2;
+  }
+
+  const int in = ::open(argv[i], O_RDONLY);
+  struct stat st;
+  if (in < 0 || ::fstat(in, &st) != 0) {
+    std::perror(argv[i]);
+    return 1;
+  }
+  const int out = i + 1 < argc ? ::open(argv[i + 1], O_WRONLY | O_CREAT | O_TRUNC, 0644) : STDOUT_FILENO;
+  if (out < 0) {
+    std::perror(argv[i + 1]);
+    return 1;
+  }
+
+  const size_t bytes = static_cast<size_t>(st.st_size);
+  const size_t width = binary32 ? sizeof(float) : sizeof(double);
+  if (bytes % (width * opts.columns) != 0)
+    std::fprintf(stderr, "warning: %zu trailing bytes are not a full row and are ignored\n", bytes % (width * opts.columns));
+  const size_t count = bytes / (width * opts.columns) * opts.columns;
+
+  void* data = nullptr;
+  if (bytes != 0) {
+    data = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, in, 0);
+    if (data == MAP_FAILED) {
+      std::perror("mmap");
+      return 1;
+    }
+    ::madvise(data, bytes, MADV_SEQUENTIAL);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  const bool ok = binary32 ? run(static_cast<const float*>(data), count, out, opts, threads)
+                           : run(static_cast<const double*>(data), count, out, opts, threads);
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if (!ok)
+    std::perror("write");
+  if (stats)
+    std::fprintf(stderr, "%zu values in %.3f s on %u threads, %.1f M values/s, %.1f MB/s in\n", count, seconds, threads,
+                 count / seconds * 1e-6, count * width / seconds * 1e-6);
+
+  if (data != nullptr)
+    ::munmap(data, bytes);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,433 @@
+//--------------------------------------------------------------------------------
+// Random differential testing of decimal_float for the wide types. Every result is
+// checked with exact big-integer arithmetic: it must lie in the rounding interval,
+// no decimal with one digit less may, and neither neighbour with as many digits
+// may be closer, ties going to the even one. These determine the correct result.
+//
+//   g++ -std=gnu++20 -O2 -march=native -pthread -I.. fuzz_decimal.cpp -o fuzz_decimal
+//   ./fuzz_decimal [-t threads] [-n samples] [-s seed] [double] [long-double] [float128]
+//
+// The samples favour the exponents at both ends of the range, which read the first
+// and last entries of pow10_residual reached by the type, subnormals and powers of
+// two and their neighbours. double and float128 run when no type is named.
+//
+// Built with clang++ -fsanitize=fuzzer -DFUZZ_LIBFUZZER the same check runs as a
+// libFuzzer target, which reads the input as a double and a float128.
+//--------------------------------------------------------------------------------
+
+#include "schubfach.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using limbs = std::vector<uint64_t>;
+
+void assign(limbs& r, __uint128_t x) {
+  r.resize(2);
+  r[0] = static_cast<uint64_t>(x);
+  r[1] = static_cast<uint64_t>(x >> 64);
+}
+
+// r = a * m.
+void multiply(const limbs& a, __uint128_t m, limbs& r) {
+  r.assign(a.size() + 2, 0);
+  for (size_t half = 0; half < 2; ++half) {
+    const uint64_t w = static_cast<uint64_t>(m >> (64 * half));
+    uint64_t carry = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+      const __uint128_t t = static_cast<__uint128_t>(a[i]) * w + r[i + half] + carry;
+      r[i + half] = static_cast<uint64_t>(t);
+      carry = static_cast<uint64_t>(t >> 64);
+    }
+    r[a.size() + half] += carry;
+  }
+}
+
+void shift_left(limbs& x, uint32_t bits) {
+  const size_t words = bits / 64, b = bits % 64, n = x.size();
+  x.resize(n + words + 1, 0);
+  for (size_t i = n + 1; i-- > 0;) {
+    const uint64_t hi = i < n ? x[i] : 0;
+    const uint64_t lo = i > 0 ? x[i - 1] : 0;
+    x[i + words] = b == 0 ? hi : (hi << b) | (lo >> (64 - b));
+  }
+  std::fill(x.begin(), x.begin() + words, 0);
+}
+
+int compare_limbs(limbs& a, limbs& b) {
+  while (!a.empty() && a.back() == 0)
+    a.pop_back();
+  while (!b.empty() && b.back() == 0)
+    b.pop_back();
+  if (a.size() != b.size())
+    return a.size() < b.size() ? -1 : 1;
+  for (size_t i = a.size(); i-- > 0;)
+    if (a[i] != b[i])
+      return a[i] < b[i] ? -1 : 1;
+  return 0;
+}
+
+enum failure { none, wrong_class, not_normalized, outside_interval, not_shortest, not_closest, failure_kinds };
+
+const char* const failure_names[failure_kinds] = {"", "wrong class or sign", "trailing zero", "outside the interval",
+                                                  "not shortest", "not closest"};
+
+template <typename Float> struct exact_checker {
+  using float_traits = schubfach::float_traits<Float>;
+  using uint_t = typename float_traits::uint_t;
+
+  struct scratch {
+    limbs a, b;
+  };
+
+  // 5^i for every decimal exponent a result or its neighbours can have.
+  std::vector<limbs> pow5;
+
+  exact_checker() {
+    const int32_t max_exponent = (float_traits::exponent_bias + float_traits::significand_width) * 30103 / 100000 + 48;
+    pow5.resize(max_exponent + 1);
+    pow5[0] = {1};
+    for (int32_t i = 1; i <= max_exponent; ++i) {
+      multiply(pow5[i - 1], 5, pow5[i]);
+      while (pow5[i].back() == 0)
+        pow5[i].pop_back();
+    }
+  }
+
+  // The sign of m * 10^j - n * 2^p, as m * 5^j * 2^(j - p) against n.
+  int compare(__uint128_t m, int32_t j, __uint128_t n, int32_t p, scratch& s) const {
+    if (j >= 0) {
+      multiply(pow5[j], m, s.a);
+      assign(s.b, n);
+    } else {
+      assign(s.a, m);
+      multiply(pow5[-j], n, s.b);
+    }
+    if (j >= p)
+      shift_left(s.a, j - p);
+    else
+      shift_left(s.b, p - j);
+    return compare_limbs(s.a, s.b);
+  }
+
+  failure check(Float value, scratch& s) const {
+    const uint_t bits = schubfach::reinterpret_bits<uint_t>(value);
+    const uint_t field = (bits & float_traits::exponent_mask) >> float_traits::exponent_shift;
+    uint_t c = bits & float_traits::significand_mask;
+    const schubfach::decimal_float<Float> decimal(value);
+
+    if (decimal.sign != ((bits & float_traits::sign_mask) != 0 ? -1 : 1))
+      return wrong_class;
+    if (field == float_traits::exponent_mask >> float_traits::exponent_shift) {
+      const uint_t explicit_bit = float_traits::has_hidden_bit ? 0 : uint_t{1} << (float_traits::significand_width - 1);
+      if ((c & ~explicit_bit) != 0)
+        return decimal.category == schubfach::float_class::quiet_nan ||
+                       decimal.category == schubfach::float_class::signaling_nan
+                   ? none
+                   : wrong_class;
+      return decimal.category == schubfach::float_class::infinity ? none : wrong_class;
+    }
+    if (field == 0 && c == 0)
+      return decimal.category == schubfach::float_class::zero ? none : wrong_class;
+    if (decimal.category != schubfach::float_class::finite)
+      return wrong_class;
+
+    if (float_traits::has_hidden_bit && field != 0)
+      c |= uint_t{1} << (float_traits::significand_width - 1);
+    const int32_t q = field == 0 ? 1 - float_traits::exponent_bias : static_cast<int32_t>(field) - float_traits::exponent_bias;
+    const bool lower_boundary_is_closer = q > 1 - float_traits::exponent_bias && std::popcount(c) == 1;
+    const bool inclusive = c % 2 == 0;
+
+    // The interval is (4c - 2 + lower_boundary_is_closer, 4c + 2) * 2^(q - 2), closed when c is even.
+    const __uint128_t lower = 4 * static_cast<__uint128_t>(c) - 2 + lower_boundary_is_closer;
+    const __uint128_t upper = 4 * static_cast<__uint128_t>(c) + 2;
+    const auto inside = [&](__uint128_t m, int32_t j) {
+      const int l = compare(m, j, lower, q - 2, s);
+      if (inclusive ? l < 0 : l <= 0)
+        return false;
+      const int u = compare(m, j, upper, q - 2, s);
+      return inclusive ? u <= 0 : u < 0;
+    };
+
+    const __uint128_t d = decimal.significand;
+    const int32_t e = decimal.exponent;
+    if (d % 10 == 0)
+      return not_normalized;
+    if (!inside(d, e))
+      return outside_interval;
+    if (inside(d / 10, e + 1) || inside(d / 10 + 1, e + 1))
+      return not_shortest;
+
+    // (2d + 1) * 10^e and (2d - 1) * 10^e against 2v = c * 2^(q + 1) place the value relative to the midpoints.
+    if (inside(d + 1, e)) {
+      const int r = compare(2 * d + 1, e, c, q + 1, s);
+      if (r < 0 || (r == 0 && d % 2 != 0))
+        return not_closest;
+    }
+    if (inside(d - 1, e)) {
+      const int r = compare(2 * d - 1, e, c, q + 1, s);
+      if (r > 0 || (r == 0 && d % 2 != 0))
+        return not_closest;
+    }
+    return none;
+  }
+};
+
+template <typename Float> struct sampler {
+  using float_traits = schubfach::float_traits<Float>;
+  using uint_t = typename float_traits::uint_t;
+  static constexpr uint_t max_field = float_traits::exponent_mask >> float_traits::exponent_shift;
+  static constexpr uint_t ends = 24;
+
+  std::mt19937_64 rng;
+
+  explicit sampler(uint64_t seed) : rng(seed) {}
+
+  uint_t random_bits(int width) {
+    const uint_t bits = static_cast<uint_t>((static_cast<__uint128_t>(rng()) << 64) | rng());
+    return width >= std::numeric_limits<uint_t>::digits ? bits : bits & ((uint_t{1} << width) - 1);
+  }
+
+  uint_t fraction() {
+    const int width = float_traits::significand_width - !float_traits::has_hidden_bit;
+    return random_bits(rng() % 4 == 0 ? static_cast<int>(rng() % width) : width) & float_traits::significand_mask;
+  }
+
+  // A normal exponent field within the first or last fields.
+  uint_t end_field() { return rng() % 2 ? 1 + rng() % ends : max_field - 1 - rng() % ends; }
+
+  Float next() {
+    uint_t field, bits;
+    switch (rng() % 16) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+    case 4:
+      field = 1 + rng() % (max_field - 1);
+      bits = fraction();
+      break;
+    case 5:
+    case 6:
+    case 7:
+      field = end_field();
+      bits = fraction();
+      break;
+    case 8:
+    case 9:
+    case 10:
+      field = 0;
+      bits = fraction();
+      break;
+    case 11:
+    case 12:
+    case 13:
+    case 14: {
+      // A power of two or one of its neighbours, a third of them near the ends of the range.
+      field = rng() % 3 == 0 ? end_field() : 1 + rng() % (max_field - 1);
+      const uint_t step = static_cast<uint_t>(rng() % 3);
+      bits = field << float_traits::exponent_shift;
+      bits = step == 1 ? bits + 1 : step == 2 ? bits - 1 : bits;
+      field = bits >> float_traits::exponent_shift;
+      bits &= float_traits::significand_mask;
+      break;
+    }
+    default:
+      field = rng() % 2 == 0 ? 0 : max_field;
+      bits = rng() % 2 == 0 ? 0 : fraction();
+      break;
+    }
+
+    bits |= field << float_traits::exponent_shift;
+    if (!float_traits::has_hidden_bit) {
+      const uint_t explicit_bit = uint_t{1} << (float_traits::significand_width - 1);
+      bits = field == 0 ? bits & ~explicit_bit : bits | explicit_bit;
+    }
+    if (rng() % 2)
+      bits |= float_traits::sign_mask;
+    return schubfach::reinterpret_bits<Float>(bits);
+  }
+};
+
+#ifdef FUZZ_LIBFUZZER
+template <typename Float> void fuzz_one(const uint8_t* data) {
+  using uint_t = typename schubfach::float_traits<Float>::uint_t;
+  static const exact_checker<Float> checker;
+  static typename exact_checker<Float>::scratch s;
+
+  uint_t bits = 0;
+  std::memcpy(&bits, data, sizeof(Float));
+  if (checker.check(schubfach::reinterpret_bits<Float>(bits), s) != none)
+    __builtin_trap();
+}
+#else
+template <typename Float> const char* type_name() {
+  if constexpr (std::is_same_v<Float, double>)
+    return "double";
+  else if constexpr (std::is_same_v<Float, long double>)
+    return "long double";
+  else
+    return "float128";
+}
+
+template <typename Float> void print_bits(Float value) {
+  const auto bits = static_cast<__uint128_t>(schubfach::reinterpret_bits<typename schubfach::float_traits<Float>::uint_t>(value));
+  if constexpr (sizeof(Float) > 8)
+    std::printf("0x%016llx%016llx", static_cast<unsigned long long>(bits >> 64), static_cast<unsigned long long>(bits));
+  else
+    std::printf("0x%016llx", static_cast<unsigned long long>(bits));
+}
+
+struct counters {
+  uint64_t values = 0;
+  uint64_t failures[failure_kinds] = {};
+  double convert_seconds = 0;
+  int32_t k_min = std::numeric_limits<int32_t>::max();
+  int32_t k_max = std::numeric_limits<int32_t>::min();
+};
+
+template <typename Float> bool run(uint64_t samples, uint64_t seed, unsigned threads) {
+  using float_traits = schubfach::float_traits<Float>;
+  using uint_t = typename float_traits::uint_t;
+  using math = schubfach::math<typename float_traits::math_uint_t>;
+  using table = schubfach::pow10_residual_table<typename float_traits::math_uint_t>;
+  constexpr size_t batch_size = 1 << 12;
+
+  const exact_checker<Float> checker;
+  std::vector<counters> results(threads);
+  const auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      sampler<Float> sample(seed * 0x9E3779B97F4A7C15 + t);
+      typename exact_checker<Float>::scratch s;
+      counters c;
+      std::vector<Float> values(batch_size);
+      volatile uint64_t sink = 0;
+
+      for (uint64_t done = samples * t / threads, last = samples * (t + 1) / threads; done < last;) {
+        const size_t n = std::min<uint64_t>(batch_size, last - done);
+        for (size_t i = 0; i < n; ++i)
+          values[i] = sample.next();
+
+        uint64_t sum = 0;
+        const auto convert_start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i) {
+          const schubfach::decimal_float<Float> decimal(values[i]);
+          sum += static_cast<uint64_t>(decimal.significand) + decimal.exponent;
+        }
+        c.convert_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - convert_start).count();
+        sink = sink + sum;
+
+        for (size_t i = 0; i < n; ++i) {
+          const uint_t bits = schubfach::reinterpret_bits<uint_t>(values[i]);
+          const uint_t field = (bits & float_traits::exponent_mask) >> float_traits::exponent_shift;
+          if (field != float_traits::exponent_mask >> float_traits::exponent_shift && (bits & float_traits::significand_mask) != 0) {
+            const int32_t q = field == 0 ? 1 - float_traits::exponent_bias : static_cast<int32_t>(field) - float_traits::exponent_bias;
+            const bool closer = field > 1 && (bits & float_traits::significand_mask & ~(uint_t{1} << (float_traits::significand_width - 1))) == 0;
+            const int32_t k = math::floor_log10_pow2(q, closer);
+            c.k_min = std::min(c.k_min, -k);
+            c.k_max = std::max(c.k_max, -k);
+          }
+
+          const failure f = checker.check(values[i], s);
+          if (f != none && c.failures[f]++ < 4) {
+            const schubfach::decimal_float<Float> decimal(values[i]);
+            char digits[40];
+            *schubfach::to_chars(digits, digits + sizeof digits - 1, decimal.significand) = '\0';
+            print_bits(values[i]);
+            std::printf(": %se%d is %s\n", digits, decimal.exponent, failure_names[f]);
+          }
+        }
+        c.values += n;
+        done += n;
+      }
+      results[t] = c;
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  counters total;
+  for (const auto& c : results) {
+    total.values += c.values;
+    for (int f = 0; f < failure_kinds; ++f)
+      total.failures[f] += c.failures[f];
+    total.convert_seconds += c.convert_seconds;
+    total.k_min = std::min(total.k_min, c.k_min);
+    total.k_max = std::max(total.k_max, c.k_max);
+  }
+
+  uint64_t failures = 0;
+  std::printf("%s: %llu values", type_name<Float>(), static_cast<unsigned long long>(total.values));
+  for (int f = 1; f < failure_kinds; ++f) {
+    failures += total.failures[f];
+    if (total.failures[f] != 0)
+      std::printf(", %llu %s", static_cast<unsigned long long>(total.failures[f]), failure_names[f]);
+  }
+  std::printf(failures == 0 ? ", all correct\n" : "\n");
+  std::printf("  pow10_residual(k) for k in [%d, %d], table [%d, %d]\n", total.k_min, total.k_max, table::k_min, table::k_max);
+  std::printf("  decimal_float %.1f M values/s per thread, checked %.2f M values/s on %u threads in %.2f s\n",
+              total.values / total.convert_seconds * 1e-6, total.values / seconds * 1e-6, threads, seconds);
+  return failures == 0;
+}
+#endif
+
+} // namespace
+
+#ifdef FUZZ_LIBFUZZER
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  if (size >= sizeof(double))
+    fuzz_one<double>(data);
+  if (size >= sizeof(__float128))
+    fuzz_one<__float128>(data);
+  return 0;
+}
+#else
+int main(int argc, char** argv) {
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  uint64_t samples = uint64_t{1} << 22;
+  uint64_t seed = 1;
+  bool binary64 = false, x87 = false, binary128 = false;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-t" && i + 1 < argc)
+      threads = std::max(1ul, std::stoul(argv[++i]));
+    else if (arg == "-n" && i + 1 < argc)
+      samples = std::stoull(argv[++i], nullptr, 0);
+    else if (arg == "-s" && i + 1 < argc)
+      seed = std::stoull(argv[++i], nullptr, 0);
+    else if (arg == "double")
+      binary64 = true;
+    else if (arg == "long-double")
+      x87 = true;
+    else if (arg == "float128")
+      binary128 = true;
+    else {
+      std::fprintf(stderr, "usage: %s [-t threads] [-n samples] [-s seed] [double] [long-double] [float128]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (!binary64 && !x87 && !binary128)
+    binary64 = binary128 = true;
+
+  bool ok = true;
+  if (binary64)
+    ok = run<double>(samples, seed, threads) && ok;
+  if (x87)
+    ok = run<long double>(samples, seed, threads) && ok;
+  if (binary128)
+    ok = run<__float128>(samples, seed, threads) && ok;
+  return ok ? 0 : 1;
+}
+#endif
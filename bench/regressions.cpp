@@ -0,0 +1,140 @@
+//--------------------------------------------------------------------------------
+// Checks for bugs that were found in review, so they stay fixed.
+//
+//   g++ -std=gnu++20 -O2 -march=native -I.. regressions.cpp -o regressions && ./regressions
+//
+// Build it at -O0 as well: without inlining, intrinsics that take an immediate operand
+// only compile when the operand is a constant expression.
+//--------------------------------------------------------------------------------
+
+#include "schubfach.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void expect(bool ok, const char* what) {
+  if (!ok) {
+    std::printf("FAIL: %s\n", what);
+    ++failures;
+  }
+}
+
+void expect_text(const char* got_first, const char* got_last, std::string_view expected, const char* what) {
+  const std::string_view got(got_first, got_last != nullptr ? got_last - got_first : 0);
+  if (got_last == nullptr || got != expected) {
+    std::printf("FAIL: %s: got \"%.*s\", expected \"%.*s\"\n", what, static_cast<int>(got.size()), got.data(),
+                static_cast<int>(expected.size()), expected.data());
+    ++failures;
+  }
+}
+
+// writer::write must take string literals and std::string as text rather than as a value to format.
+void writer_separators() {
+  char buffer[64];
+  auto refill = [&](char*, char*) { return std::pair<char*, char*>(buffer, buffer + sizeof buffer); };
+  schubfach::writer w(buffer, buffer + sizeof buffer, refill);
+
+  const std::string separator = "; ";
+  const double values[] = {1.5, 2};
+  expect(w.write(0.25) && w.write(",") && w.write(separator) && w.write(values, 2, separator), "writer::write");
+  expect_text(buffer, w.cursor, "0.25,; 1.5; 2", "writer with string separators");
+}
+
+// Integers whose shortest digits end in zeros are written with their exact digits, as std::to_chars does.
+void exact_integers() {
+  char buffer[64];
+  expect_text(buffer, schubfach::to_chars(buffer, buffer + sizeof buffer, 397605984.f), "397605984", "to_chars(397605984.f)");
+  expect_text(buffer, schubfach::to_chars(buffer, buffer + sizeof buffer, 4542252887857070080.0), "4542252887857070080",
+              "to_chars(4542252887857070080.0)");
+  expect_text(buffer, schubfach::to_chars(buffer, buffer + sizeof buffer, -4542252887857070080.0), "-4542252887857070080",
+              "to_chars(-4542252887857070080.0)");
+
+  schubfach::decimal_cache<float> cache;
+  expect_text(buffer, cache.to_chars(buffer, buffer + sizeof buffer, 397605984.f), "397605984", "decimal_cache::to_chars");
+
+  constexpr auto fixed = schubfach::to_fixed_string<397605984.f>();
+  expect(std::string_view(fixed.data()) == "397605984", "to_fixed_string<397605984.f>");
+}
+
+// to_chars without a format matches std::to_chars on random bit patterns.
+template <typename Float> void matches_std_to_chars(size_t count) {
+  using uint_t = typename schubfach::float_traits<Float>::uint_t;
+  std::mt19937_64 rng(1);
+  size_t mismatches = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const Float value = schubfach::reinterpret_bits<Float>(static_cast<uint_t>(rng()));
+    char expected[64], got[64];
+    const char* expected_last = std::to_chars(expected, expected + sizeof expected, value).ptr;
+    const char* got_last = schubfach::to_chars(got, got + sizeof got, value);
+    if (value != value)
+      continue;
+    if (got_last == nullptr || std::string_view(got, got_last - got) != std::string_view(expected, expected_last - expected)) {
+      if (mismatches++ < 4)
+        expect_text(got, got_last, std::string_view(expected, expected_last - expected), "to_chars against std::to_chars");
+    }
+  }
+  expect(mismatches == 0, sizeof(Float) == 4 ? "float matches std::to_chars" : "double matches std::to_chars");
+}
+
+// Every unsigned integer type is written as an integer; signed integers and other non-float types are rejected
+// instead of being converted through the float overload.
+template <typename T>
+constexpr bool formattable = requires(char* p, T value) { schubfach::to_chars(p, p, value); };
+
+static_assert(!formattable<int> && !formattable<long> && !formattable<bool> && !formattable<const char*>);
+static_assert(formattable<uint16_t> && formattable<unsigned long long> && formattable<__uint128_t>);
+
+void unsigned_integers() {
+  char buffer[64];
+  expect_text(buffer, schubfach::to_chars(buffer, buffer + sizeof buffer, uint16_t{7}), "7", "to_chars(uint16_t{7})");
+  expect_text(buffer, schubfach::to_chars(buffer, buffer + sizeof buffer, 42ull), "42", "to_chars(42ull)");
+  expect_text(buffer, schubfach::to_chars(buffer, buffer + sizeof buffer, 42u), "42", "to_chars(42u)");
+  expect_text(buffer, schubfach::to_chars(buffer, buffer + sizeof buffer, static_cast<unsigned char>(255)), "255",
+              "to_chars(unsigned char)");
+  expect(schubfach::count_digits(10000000000ull) == 11, "count_digits(unsigned long long)");
+  uint16_t hundred = 100;
+  expect(schubfach::remove_trailing_zeros(hundred) == 2 && hundred == 1, "remove_trailing_zeros(uint16_t)");
+}
+
+// The SIMD kernels of convert_batch agree with decimal_float.
+void convert_batch_matches() {
+  std::mt19937 rng(2);
+  std::vector<float> in(1000);
+  for (float& value : in)
+    value = schubfach::reinterpret_bits<float>(static_cast<uint32_t>(rng()));
+  std::vector<uint32_t> significands(in.size());
+  std::vector<int32_t> exponents(in.size());
+  std::vector<int8_t> signs(in.size());
+  std::vector<schubfach::float_class> classes(in.size());
+  schubfach::convert_batch(in.data(), in.size(), significands.data(), exponents.data(), signs.data(), classes.data());
+  size_t mismatches = 0;
+  for (size_t i = 0; i < in.size(); ++i) {
+    const schubfach::decimal_float<float> decimal(in[i]);
+    if (classes[i] != decimal.category || signs[i] != decimal.sign ||
+        (decimal.category == schubfach::float_class::finite &&
+         (significands[i] != decimal.significand || exponents[i] != decimal.exponent)))
+      ++mismatches;
+  }
+  expect(mismatches == 0, "convert_batch matches decimal_float");
+}
+
+} // namespace
+
+int main() {
+  writer_separators();
+  exact_integers();
+  unsigned_integers();
+  convert_batch_matches();
+  matches_std_to_chars<float>(1 << 22);
+  matches_std_to_chars<double>(1 << 22);
+  std::printf(failures == 0 ? "all passed\n" : "%d failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,9 @@
+//--------------------------------------------------------------------------------
+// Defines the residual tables for programs built with SCHUBFACH_SEPARATE_TABLES.
+// Compile this file once, with the same SCHUBFACH_COMPACT_TABLES setting as the
+// rest of the program.
+//--------------------------------------------------------------------------------
+
+#define SCHUBFACH_SEPARATE_TABLES 1
+#define SCHUBFACH_DEFINE_TABLES 1
+#include "schubfach.hpp"